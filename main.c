@@ -22,6 +22,8 @@
 
     #include <X11/Xlib.h>
     #include <X11/Xutil.h>
+    #include <xcb/xcb.h>
+    #include <sys/stat.h>
 
 #elif __WIN32__
 
@@ -34,6 +36,12 @@
 #include <string.h>
 #include <errno.h>
 
+#if defined(__SSE2__)
+
+    #include <emmintrin.h>
+
+#endif
+
 #include "SDL2/SDL.h"
 #include "glad/glad.h"
 #include "cglm/cglm.h"
@@ -58,6 +66,67 @@
     #define ZOOMER_DISPLAY_HEIGHT 1080
 #endif // ZOOMER_DISPLAY_HEIGHT
 
+#ifndef ZOOMER_SHADER_CACHE
+    #define ZOOMER_SHADER_CACHE 1 // Store linked shader programs on disk and reuse them on the next launch (0 - disabled, 1 - enabled)
+#endif // ZOOMER_SHADER_CACHE
+
+#ifndef ZOOMER_FRAME_PACING
+    #define ZOOMER_FRAME_PACING 1 // Frame pacing mode (0 - vsync, 1 - adaptive vsync + fence, 2 - adaptive vsync + glFinish)
+#endif // ZOOMER_FRAME_PACING
+
+#ifndef ZOOMER_LATENCY_FRAMES
+    #define ZOOMER_LATENCY_FRAMES 120 // Number of frames over which the input-to-present latency is reported
+#endif // ZOOMER_LATENCY_FRAMES
+
+#ifndef ZOOMER_CAPTURE_XCB
+    #define ZOOMER_CAPTURE_XCB 1 // Screen capture backend on Linux (0 - Xlib, 1 - XCB)
+#endif // ZOOMER_CAPTURE_XCB
+
+#ifndef ZOOMER_CAPTURE_TILE
+    #define ZOOMER_CAPTURE_TILE 64 // Height (in rows) of a single tile requested by the XCB backend
+#endif // ZOOMER_CAPTURE_TILE
+
+#ifndef ZOOMER_INSPECTOR_THREADS
+    #define ZOOMER_INSPECTOR_THREADS 8 // Maximal number of threads used to compute the statistics of the selected region
+#endif // ZOOMER_INSPECTOR_THREADS
+
+#ifndef ZOOMER_INSPECTOR_THREAD_PIXELS
+    #define ZOOMER_INSPECTOR_THREAD_PIXELS 65536 // Minimal number of pixels per thread (smaller regions use less threads)
+#endif // ZOOMER_INSPECTOR_THREAD_PIXELS
+
+#define ZOOMER_INSPECTOR_HIST_W 256
+#define ZOOMER_INSPECTOR_HIST_H 128
+#define ZOOMER_INSPECTOR_TEXT_W 256
+#define ZOOMER_INSPECTOR_TEXT_H 72
+#define ZOOMER_INSPECTOR_COLORS ((1 << 24) / 64) // Number of 64-bit words in the bitset of all the 24-bit colors
+
+#ifndef ZOOMER_OVERLAY_ZOOM
+    #define ZOOMER_OVERLAY_ZOOM 8.0f // Zoom level from which the pixel grid, crosshair and rulers are displayed
+#endif // ZOOMER_OVERLAY_ZOOM
+
+#ifndef ZOOMER_OVERLAY_VERTICES
+    #define ZOOMER_OVERLAY_VERTICES 4096 // Capacity of the overlay vertex stream (6 vertices per quad)
+#endif // ZOOMER_OVERLAY_VERTICES
+
+#ifndef ZOOMER_RULER_SIZE
+    #define ZOOMER_RULER_SIZE 32.0f // Thickness (in screen pixels) of the coordinate rulers
+#endif // ZOOMER_RULER_SIZE
+
+#define ZOOMER_OVERLAY_STRIDE 9 // Floats per overlay vertex: position (2), color (4), world (2), kind (1)
+
+// Layout of the overlay atlas: the inspector's readout & histogram and the glyphs of the ruler labels share one texture
+#define ZOOMER_ATLAS_W 512
+#define ZOOMER_ATLAS_H 256
+#define ZOOMER_ATLAS_READOUT_X 0
+#define ZOOMER_ATLAS_READOUT_Y 0
+#define ZOOMER_ATLAS_HIST_X ZOOMER_INSPECTOR_TEXT_W
+#define ZOOMER_ATLAS_HIST_Y 0
+#define ZOOMER_ATLAS_FONT_X 0
+#define ZOOMER_ATLAS_FONT_Y ZOOMER_INSPECTOR_HIST_H
+#define ZOOMER_ATLAS_FONT "0123456789-" // Glyphs available to 'ft_overlay_text' (6 pixels apart, 5x7 each)
+
+#define ZOOMER_SHADER_CACHE_MAGIC 0x43534d5a // "ZMSC" in little-endian byte order
+
 // -------------------------
 // SECTION: Global Variables
 // -------------------------
@@ -95,6 +164,55 @@ const char* glsl_frag =
 "       f_Col = v_Col;\n"
 "}";
 
+// The overlay program draws everything in the screen space.
+// The pixel grid and the ruler ticks are not geometry, they're generated from the interpolated world coordinates (a_World),
+// so they always cost a single quad, no matter the zoom level or how many pixels are visible.
+// The textured quads (kind 3) reuse a_World as the coordinates into the overlay atlas
+const char* glsl_overlay_vert =
+"#version 460 core\n"
+"layout (location = 0) in vec2 a_Pos;\n"
+"layout (location = 1) in vec4 a_Col;\n"
+"layout (location = 2) in vec2 a_World;\n"
+"layout (location = 3) in float a_Kind;\n"
+"out vec4 v_Col;\n"
+"out vec2 v_World;\n"
+"flat out int v_Kind;\n"
+"uniform mat4 u_proj;\n"
+"void main() {\n"
+"	gl_Position = u_proj * vec4(a_Pos, 0.0f, 1.0f);\n"
+"	v_Col = a_Col;\n"
+"	v_World = a_World;\n"
+"	v_Kind = int(a_Kind);\n"
+"}";
+
+const char* glsl_overlay_frag =
+"#version 460 core\n"
+"in vec4 v_Col;\n"
+"in vec2 v_World;\n"
+"flat in int v_Kind;\n"
+"out vec4 f_Col;\n"
+"uniform sampler2D u_Texture;\n"
+"float ft_line(float coord, float unit, float width) {\n"
+"	float f = fract(coord / unit);\n"
+"	return 1.0f - clamp(min(f, 1.0f - f) / (width / unit), 0.0f, 1.0f);\n"
+"}\n"
+"void main() {\n"
+"	vec2 width = fwidth(v_World);\n"
+"	vec4 texel = texture(u_Texture, v_World);\n"
+"	float alpha = 1.0f;\n"
+"	if(v_Kind == 1) {\n"
+"		alpha = max(ft_line(v_World.x, 1.0f, width.x), ft_line(v_World.y, 1.0f, width.y));\n"
+"	} else if(v_Kind == 2) {\n"
+"		float index = floor(v_World.x + 0.5f);\n"
+"		float len = mod(index, 10.0f) == 0.0f ? 0.5f : (mod(index, 5.0f) == 0.0f ? 0.35f : 0.2f);\n"
+"		alpha = ft_line(v_World.x, 1.0f, width.x) * step(1.0f - len, v_World.y);\n"
+"	} else if(v_Kind == 3) {\n"
+"		f_Col = texel * v_Col;\n"
+"		return;\n"
+"	}\n"
+"	f_Col = vec4(v_Col.rgb, v_Col.a * alpha);\n"
+"}";
+
 // -----------------
 // SECTION: Typedefs
 // -----------------
@@ -112,6 +230,57 @@ typedef struct s_cam2d {
     float scale;
 } t_cam2d;
 
+typedef struct s_stats {
+    unsigned char min[4];
+    unsigned char max[4];
+    unsigned long long sum[4];
+    float mean[4];
+    unsigned int histogram[4][256];
+    unsigned int unique;
+    unsigned int count;
+} t_stats;
+
+typedef struct s_stats_job {
+    const unsigned char* data;
+    int stride;
+    int rect[4];
+    unsigned long long* colors;
+    t_stats stats;
+} t_stats_job;
+
+typedef struct s_inspector {
+    int enabled;
+    int selecting;
+
+    int pixel[2];
+    unsigned char color[4];
+
+    vec2 sel_begin;
+    vec2 sel_end;
+    int rect[4];
+
+    t_stats stats;
+    unsigned long long* colors[ZOOMER_INSPECTOR_THREADS];
+} t_inspector;
+
+typedef struct s_shcache_header {
+    unsigned int magic;
+    unsigned int format;
+    unsigned int size;
+    unsigned int reserved;
+    unsigned long long hash;
+} t_shcache_header;
+
+typedef struct s_overlay {
+    unsigned int sh_prog;
+    unsigned int vert_arr;
+    unsigned int vert_buf;
+    t_tex2d atlas;
+
+    int count;
+    float vertices[ZOOMER_OVERLAY_VERTICES * ZOOMER_OVERLAY_STRIDE];
+} t_overlay;
+
 typedef struct s_core {
     void* window;
     SDL_GLContext context;
@@ -119,15 +288,26 @@ typedef struct s_core {
 
     unsigned int sh_prog;
 
+    t_overlay overlay;
+
     vec2 mouse_wheel;
 
     vec2 mouse_pos;
     vec2 mouse_pos_prev;
 
-    int mouse_button[3];
+    int mouse_button[SDL_BUTTON_X2 + 1];
+    int mouse_button_prev[SDL_BUTTON_X2 + 1];
 
     int key[SDL_NUM_SCANCODES];
     int key_prev[SDL_NUM_SCANCODES];
+
+    int pacing;
+    int input;
+    Uint32 time_input;
+
+    int latency_report;
+    int latency_count;
+    double latency[ZOOMER_LATENCY_FRAMES];
 } t_core;
 
 static t_core CORE;
@@ -145,27 +325,76 @@ int ft_init_window(unsigned int w, unsigned int h, const char* title);
 int ft_init_opengl(void);
 
 int ft_poll_events(void);
+int ft_poll_motion(void);
 int ft_should_quit(void);
 int ft_display(void);
+int ft_show(void);
 int ft_quit(void);
 
+int ft_frame_pace(void);
+int ft_latency_input(Uint32 timestamp);
+int ft_latency_report(void);
+
+// ----------------------------
+// SECTION: Functions - Shaders
+// ----------------------------
+
+unsigned int ft_shader_compile(GLenum type, const char* src);
+unsigned int ft_shader_program(const char* vert, const char* frag, const char* variant);
+
+unsigned long long ft_shader_hash(const char* vert, const char* frag, const char* variant);
+int ft_shader_cache_path(const char* variant, char* dest, size_t size);
+unsigned int ft_shader_cache_load(const char* path, unsigned long long hash);
+int ft_shader_cache_save(const char* path, unsigned long long hash, unsigned int prog);
+
 // -----------------------------------
 // SECTION: Functions - Screen Capture
 // -----------------------------------
 
-char* ft_screen_capture(int w, int h);
+char* ft_screen_capture(int w, int h, t_tex2d* tex);
+char* ft_screen_capture_xlib(int w, int h, t_tex2d* tex);
+char* ft_screen_capture_xcb(int w, int h, t_tex2d* tex);
+int ft_screen_capture_bench(int iterations);
+int ft_bgra_to_rgba(char* dest, const char* src, int count);
 
 // ------------------------------
 // SECTION: Functions - Texturing
 // ------------------------------
 t_tex2d ft_tex2d(int w, int h, char* data);
+int ft_tex2d_update(t_tex2d tex, char* data);
+int ft_tex2d_update_rec(t_tex2d tex, int x, int y, int w, int h, char* data);
 int ft_draw_tex2d(t_tex2d tex, vec2 position, vec2 size);
+int ft_draw_quad(unsigned int tex_id, vec2 position, vec2 size, vec4 color);
+
+// ----------------------------
+// SECTION: Functions - Overlay
+// ----------------------------
+
+int ft_overlay_init(void);
+int ft_overlay_quit(void);
+
+int ft_overlay_begin(void);
+int ft_overlay_end(void);
+
+int ft_overlay_vertex(float x, float y, vec4 color, float world_x, float world_y, float kind);
+int ft_overlay_quad(vec2 position, vec2 size, vec4 color, float kind, vec2 world[4]);
+int ft_overlay_rec(vec2 position, vec2 size, vec4 color);
+int ft_overlay_line(vec2 begin, vec2 end, float thickness, vec4 color);
+int ft_overlay_tex(vec2 position, vec2 size, vec4 color, int src[4]);
+int ft_overlay_text(vec2 position, const char* text, vec4 color);
+int ft_overlay_atlas(int x, int y, int w, int h, char* data);
+
+int ft_overlay_grid(t_cam2d cam, vec2 size);
+int ft_overlay_crosshair(t_cam2d cam);
+int ft_overlay_rulers(t_cam2d cam);
 
 // -----------------------------
 // SECTION: Functions - Inputing
 // -----------------------------
 int ft_mousedown(int button);
 int ft_mouseup(int button);
+int ft_mousepress(int button);
+int ft_mouserelease(int button);
 float ft_mousewheel(void);
 
 int ft_keydown(SDL_Scancode code);
@@ -179,11 +408,27 @@ int ft_keyrelease(SDL_Scancode code);
 
 int ft_cam2d_display(t_cam2d cam);
 int ft_screen_to_world(t_cam2d cam, vec2 src, vec2 dest);
+int ft_world_to_screen(t_cam2d cam, vec2 src, vec2 dest);
 int ft_cam2d_matrix(t_cam2d cam, mat4 dest);
 
 int ft_cam2d_pan(t_cam2d* cam);
 int ft_cam2d_zoom(t_cam2d* cam);
 
+// ------------------------------
+// SECTION: Functions - Inspector
+// ------------------------------
+
+int ft_inspector_init(t_inspector* insp);
+int ft_inspector_update(t_inspector* insp, t_cam2d cam, char* data, int w, int h);
+int ft_inspector_overlay(t_inspector* insp, t_cam2d cam);
+int ft_inspector_quit(t_inspector* insp);
+
+int ft_inspector_readout(t_inspector* insp);
+int ft_raster_text(char* data, int w, int h, int x, int y, const char* text);
+
+int ft_region_stats(t_inspector* insp, char* data, int w, int rect[4], t_stats* dest);
+int ft_region_stats_job(void* arg);
+
 // ----------------
 // SECTION: Program
 // ----------------
@@ -194,17 +439,30 @@ int main(int argc, const char* argv[]) {
     // SECTION: Program - Load
     // -----------------------
 
-    char* capture_data = ft_screen_capture(ZOOMER_DISPLAY_WIDTH, ZOOMER_DISPLAY_HEIGHT);
+#ifdef __linux__
+
+    // Capture benchmark (i.e.: $ xvfb-run -s "-screen 0 3840x2160x24" ./zoomer --bench-capture 32)
+    if(argc > 1 && strcmp(argv[1], "--bench-capture") == 0)
+        return !ft_screen_capture_bench(argc > 2 ? atoi(argv[2]) : 16);
 
-    if(!ft_init(ZOOMER_DISPLAY_WIDTH, ZOOMER_DISPLAY_HEIGHT, "Zoomer | 1.0.0")) {
-        free(capture_data);
+#endif
 
+    // The window is created hidden, so it doesn't end up in the capture.
+    // This way the GL context already exists while capturing and every tile is uploaded as soon as it arrives
+    if(!ft_init(ZOOMER_DISPLAY_WIDTH, ZOOMER_DISPLAY_HEIGHT, "Zoomer | 1.0.0"))
         return 1;
-    } 
 
-    t_tex2d capture_texture = ft_tex2d(ZOOMER_DISPLAY_WIDTH, ZOOMER_DISPLAY_HEIGHT, capture_data);
+    // The CPU copy of the capture is kept for the pixel inspector
+    t_tex2d capture_texture = ft_tex2d(ZOOMER_DISPLAY_WIDTH, ZOOMER_DISPLAY_HEIGHT, NULL);
+    char* capture_data = ft_screen_capture(ZOOMER_DISPLAY_WIDTH, ZOOMER_DISPLAY_HEIGHT, &capture_texture);
+
+    ft_show();
     t_cam2d cam = { .scale = 1.0f };
     int cam_reset = 0;
+    int overlay = 1;
+
+    t_inspector inspector = { 0 };
+    ft_inspector_init(&inspector);
 
 	while(!ft_should_quit()) {
 
@@ -212,8 +470,31 @@ int main(int argc, const char* argv[]) {
         // SECTION: Program - Update
         // -------------------------
 
+        // Keyboard, buttons & wheel (the mouse motion is sampled again, later, right before the camera is updated)
+        ft_poll_events();
+
+        // Input-to-present latency report (toggled with 'L')
+        if(ft_keypress(SDL_SCANCODE_L))
+            CORE.latency_report = !CORE.latency_report;
+
+        // Pixel inspector (toggled with 'I', the region is selected with 'LSHIFT' + 'LMB')
+        if(ft_keypress(SDL_SCANCODE_I)) {
+            inspector.enabled = !inspector.enabled;
+            inspector.selecting = 0;
+        }
+        if(inspector.enabled)
+            ft_inspector_update(&inspector, cam, capture_data, ZOOMER_DISPLAY_WIDTH, ZOOMER_DISPLAY_HEIGHT);
+
+        // Pixel grid, crosshair & rulers (toggled with 'G')
+        if(ft_keypress(SDL_SCANCODE_G))
+            overlay = !overlay;
+
+        // The heavy work (i.e. the region statistics) is already done above, so the mouse is sampled as late as possible:
+        // right before the camera is updated and displayed
+        ft_poll_motion();
+
         // Camera panning
-        if(ft_mousedown(SDL_BUTTON_LEFT) || ft_mousedown(SDL_BUTTON_RIGHT)) // Mouse-based movement
+        if((ft_mousedown(SDL_BUTTON_LEFT) && !inspector.selecting) || ft_mousedown(SDL_BUTTON_RIGHT)) // Mouse-based movement
             ft_cam2d_pan(&cam);   
 
         // Keyboard-based movement
@@ -265,8 +546,21 @@ int main(int argc, const char* argv[]) {
         ft_cam2d_display(cam);
         ft_draw_tex2d(capture_texture, (vec2) { 0.0f, 0.0f }, (vec2) { ZOOMER_DISPLAY_WIDTH, ZOOMER_DISPLAY_HEIGHT });
 
+        // All the overlays are collected into a single batch and drawn with a single draw call
+        ft_overlay_begin();
+
+        if(overlay && cam.scale >= ZOOMER_OVERLAY_ZOOM) {
+            ft_overlay_grid(cam, (vec2) { ZOOMER_DISPLAY_WIDTH, ZOOMER_DISPLAY_HEIGHT });
+            ft_overlay_crosshair(cam);
+            ft_overlay_rulers(cam);
+        }
+
+        if(inspector.enabled)
+            ft_inspector_overlay(&inspector, cam);
+
+        ft_overlay_end();
+
         ft_display();
-	    ft_poll_events();	
 	}
     
     // ------------------------
@@ -275,6 +569,7 @@ int main(int argc, const char* argv[]) {
 
     free(capture_data);
     glDeleteTextures(1, &capture_texture.id);
+    ft_inspector_quit(&inspector);
 
     ft_quit();
 
@@ -290,12 +585,16 @@ int main(int argc, const char* argv[]) {
 // ------------------------------
 
 int ft_init(unsigned int w, unsigned int h, const char* title) {
-    int result = 0;
+    if(!ft_init_window(w, h, title))
+        return 0;
 
-    result = ft_init_window(w, h, title);
-    result = ft_init_opengl();
+    if(!ft_init_opengl()) {
+        ft_quit();
 
-    return result;
+        return 0;
+    }
+
+    return 1;
 }
 
 
@@ -316,7 +615,7 @@ int ft_init_window(unsigned int w, unsigned int h, const char* title) {
 		SDL_WINDOWPOS_CENTERED,
 		w,
 	    h,
-		SDL_WINDOW_OPENGL | SDL_WINDOW_FULLSCREEN | SDL_WINDOW_BORDERLESS
+		SDL_WINDOW_OPENGL | SDL_WINDOW_FULLSCREEN | SDL_WINDOW_BORDERLESS | SDL_WINDOW_HIDDEN
 	);
 
     if(!CORE.window) {
@@ -328,7 +627,11 @@ int ft_init_window(unsigned int w, unsigned int h, const char* title) {
 
 	CORE.context = SDL_GL_CreateContext(CORE.window);
 	SDL_GL_MakeCurrent(CORE.window, CORE.context);
-	SDL_GL_SetSwapInterval(1);
+
+	// Adaptive vsync swaps the late frames immediately instead of holding them until the next vertical blank
+	CORE.pacing = ZOOMER_FRAME_PACING;
+	if(!CORE.pacing || SDL_GL_SetSwapInterval(-1) != 0)
+		SDL_GL_SetSwapInterval(1);
 
 	gladLoadGL();
 
@@ -338,27 +641,15 @@ int ft_init_window(unsigned int w, unsigned int h, const char* title) {
 }
 
 int ft_init_opengl(void) {
-    GLuint sh_vert = glCreateShader(GL_VERTEX_SHADER);
-    GLuint sh_frag = glCreateShader(GL_FRAGMENT_SHADER);
-
-    glShaderSource(sh_vert, 1, &glsl_vert, NULL);
-    glShaderSource(sh_frag, 1, &glsl_frag, NULL);
-
-    glCompileShader(sh_vert);
-    glCompileShader(sh_frag);
-
-    GLuint sh_prog = glCreateProgram();
-    glAttachShader(sh_prog, sh_vert);
-    glAttachShader(sh_prog, sh_frag);
-    glLinkProgram(sh_prog);
+    GLuint sh_prog = ft_shader_program(glsl_vert, glsl_frag, "tex2d");
+    if(!sh_prog)
+        return 0;
 
-    glDeleteShader(sh_vert);
-    glDeleteShader(sh_frag);
     glUseProgram(sh_prog);
 
     CORE.sh_prog = sh_prog;
 
-    return 1;
+    return ft_overlay_init();
 }
 
 int ft_poll_events(void) {
@@ -368,6 +659,9 @@ int ft_poll_events(void) {
     for(int i = 0; i < SDL_NUM_SCANCODES; i++)
         CORE.key_prev[i] = CORE.key[i];
 
+    for(int i = 0; i <= SDL_BUTTON_X2; i++)
+        CORE.mouse_button_prev[i] = CORE.mouse_button[i];
+
     CORE.mouse_wheel[0] = 0.0f;
     CORE.mouse_wheel[1] = 0.0f;
 
@@ -381,19 +675,27 @@ int ft_poll_events(void) {
             case SDL_MOUSEMOTION: {
                 CORE.mouse_pos[0] = event.motion.x;
                 CORE.mouse_pos[1] = event.motion.y;
+
+                ft_latency_input(event.common.timestamp);
             } break;
 
             case SDL_MOUSEBUTTONDOWN: {
                 CORE.mouse_button[event.button.button] = 1;
+
+                ft_latency_input(event.common.timestamp);
             } break;
 
             case SDL_MOUSEBUTTONUP: {
                 CORE.mouse_button[event.button.button] = 0;
+
+                ft_latency_input(event.common.timestamp);
             } break;
 
             case SDL_MOUSEWHEEL: {
                 CORE.mouse_wheel[0] = event.wheel.x;
                 CORE.mouse_wheel[1] = event.wheel.y;
+
+                ft_latency_input(event.common.timestamp);
             } break;
 
             case SDL_KEYDOWN: {
@@ -412,6 +714,36 @@ int ft_poll_events(void) {
     return 1;
 }
 
+int ft_poll_motion(void) {
+    // Only the mouse motion is taken out of the queue here, every other event waits for the next 'ft_poll_events'.
+    // The motion queued after a button or wheel event stays there too, otherwise e.g. a click would be applied at the wrong position
+    SDL_Event events[64];
+    int count = 0;
+
+    SDL_PumpEvents();
+    while((count = SDL_PeepEvents(events, 64, SDL_PEEKEVENT, SDL_MOUSEMOTION, SDL_MOUSEWHEEL)) > 0) {
+        int motion = 0;
+        while(motion < count && events[motion].type == SDL_MOUSEMOTION)
+            motion++;
+
+        // The oldest motion events are exactly the ones peeked in front of the first button or wheel event
+        if(motion > 0)
+            motion = SDL_PeepEvents(events, motion, SDL_GETEVENT, SDL_MOUSEMOTION, SDL_MOUSEMOTION);
+
+        for(int i = 0; i < motion; i++) {
+            CORE.mouse_pos[0] = events[i].motion.x;
+            CORE.mouse_pos[1] = events[i].motion.y;
+
+            ft_latency_input(events[i].common.timestamp);
+        }
+
+        if(motion < count || count < 64)
+            break;
+    }
+
+    return 1;
+}
+
 int ft_should_quit(void) {
     return CORE.exit;
 }
@@ -419,10 +751,86 @@ int ft_should_quit(void) {
 int ft_display(void) {
 	SDL_GL_SwapWindow(CORE.window);
 
+    ft_frame_pace();
+
+    return 1;
+}
+
+int ft_show(void) {
+    SDL_ShowWindow(CORE.window);
+
+    return 1;
+}
+
+int ft_frame_pace(void) {
+    // Waiting for the GPU to finish the frame we've just swapped, so that no frames queue up behind it
+    // and the next input sample is as close to the next present as possible
+    if(CORE.pacing == 1) {
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        if(fence) {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000); // Timeout: 100ms (in nanoseconds)
+            glDeleteSync(fence);
+        }
+    } else if(CORE.pacing == 2)
+        glFinish();
+
+    // Latency: from the oldest mouse event handled in this frame to the moment the GPU finished the frame after the swap.
+    // This doesn't include the scanout, and without the wait above (pacing: 0) it only measures until the swap returned
+    if(CORE.input) {
+        CORE.latency[CORE.latency_count++] = (double) (Uint32) (SDL_GetTicks() - CORE.time_input);
+        CORE.input = 0;
+
+        if(CORE.latency_count == ZOOMER_LATENCY_FRAMES) {
+            if(CORE.latency_report)
+                ft_latency_report();
+
+            CORE.latency_count = 0;
+        }
+    }
+
+    return 1;
+}
+
+int ft_latency_input(Uint32 timestamp) {
+    // Keeping the oldest event of the frame (the event timestamps and 'SDL_GetTicks' share the same clock)
+    if(!CORE.input || (Sint32) (timestamp - CORE.time_input) < 0)
+        CORE.time_input = timestamp;
+
+    CORE.input = 1;
+
+    return 1;
+}
+
+int ft_latency_report(void) {
+    if(!CORE.latency_count)
+        return 0;
+
+    double latency_min = CORE.latency[0];
+    double latency_max = CORE.latency[0];
+    double latency_sum = 0.0;
+
+    for(int i = 0; i < CORE.latency_count; i++) {
+        latency_min = CORE.latency[i] < latency_min ? CORE.latency[i] : latency_min;
+        latency_max = CORE.latency[i] > latency_max ? CORE.latency[i] : latency_max;
+        latency_sum += CORE.latency[i];
+    }
+
+    fprintf(stdout, "[ INFO ] Latency (mouse event -> %s): avg: %.2f ms, min: %.2f ms, max: %.2f ms (frames with input: %d, pacing: %d, swap interval: %d)\n",
+        CORE.pacing ? "frame finished on the GPU after the swap" : "swap returned",
+        latency_sum / CORE.latency_count,
+        latency_min,
+        latency_max,
+        CORE.latency_count,
+        CORE.pacing,
+        SDL_GL_GetSwapInterval()
+    );
+
     return 1;
 }
 
 int ft_quit(void) {
+    ft_overlay_quit();
     glDeleteProgram(CORE.sh_prog);
 
     SDL_GL_DeleteContext(CORE.context);
@@ -432,167 +840,960 @@ int ft_quit(void) {
     return 1;
 }
 
-// -----------------------------------
-// SECTION: Functions - Screen Capture
-// -----------------------------------
-
-char* ft_screen_capture(int w, int h) {
+// ----------------------------
+// SECTION: Functions - Shaders
+// ----------------------------
 
-#ifdef __linux__
+unsigned int ft_shader_compile(GLenum type, const char* src) {
+    GLuint sh = glCreateShader(type);
 
-    // Get the default displays "display" and "root"
-    Display* x_display = XOpenDisplay(NULL);
-    Window x_root = DefaultRootWindow(x_display);
-    
-    // Create an XImage of the screen, with the offset 0-0 and the size 1920-1080
-    XImage* x_image = XGetImage(
-        x_display, x_root,
-        0, 0,
-        w, h,
-        AllPlanes,
-        ZPixmap
-    );
+    glShaderSource(sh, 1, &src, NULL);
+    glCompileShader(sh);
 
-    if(!x_image) {
-        fprintf(stdout, "[ ERR ] X11: Could not create an X11 Image\n");
+    GLint status = GL_FALSE;
+    glGetShaderiv(sh, GL_COMPILE_STATUS, &status);
+    if(status != GL_TRUE) {
+        char log[1024] = { 0 };
+        glGetShaderInfoLog(sh, sizeof(log), NULL, log);
+        fprintf(stdout, "[ ERR ] GLSL: Could not compile the %s shader:\n%s\n", type == GL_VERTEX_SHADER ? "vertex" : "fragment", log);
 
-        XCloseDisplay(x_display);
+        glDeleteShader(sh);
 
-        return NULL;
+        return 0;
     }
 
-    // Allocate enough memory to fit in 1920-1080 image. Every color consists of 4 channels, so we need to multiply the output by 4
-    char* data = (char*) calloc(w * h * 4, sizeof(char));
-    if(!data) {
-        fprintf(stderr, "[ ERR ] X11: %s\n", strerror(errno));
+    return sh;
+}
 
-        XDestroyImage(x_image);
-        XCloseDisplay(x_display);
+unsigned int ft_shader_program(const char* vert, const char* frag, const char* variant) {
+    unsigned long long hash = ft_shader_hash(vert, frag, variant);
+    char path[1024] = { 0 };
+    int cached = ZOOMER_SHADER_CACHE && ft_shader_cache_path(variant, path, sizeof(path));
 
-        return NULL;
+    // Try the program binary from the previous launch first...
+    if(cached) {
+        GLuint sh_prog = ft_shader_cache_load(path, hash);
+        if(sh_prog)
+            return sh_prog;
     }
 
-    // Copy all the bytes from the image to the "data" array
-    // X11 internally uses BGRA byte order, so we need to shift the values to the RGBA order
-    for(int i = 0; i < w * h * 4; i += 4) {
-        data[i + 0] = x_image->data[i + 2];
-        data[i + 1] = x_image->data[i + 1];
-        data[i + 2] = x_image->data[i + 0];
-        data[i + 3] = x_image->data[i + 3];
+    // ... and if there's none (or the driver rejected it), we compile the program from source
+    GLuint sh_vert = ft_shader_compile(GL_VERTEX_SHADER, vert);
+    GLuint sh_frag = ft_shader_compile(GL_FRAGMENT_SHADER, frag);
+    if(!sh_vert || !sh_frag) {
+        glDeleteShader(sh_vert);
+        glDeleteShader(sh_frag);
+
+        return 0;
     }
-    
-    // Clean-up
-    XDestroyImage(x_image);
-    XCloseDisplay(x_display);
 
-    return data;
+    GLuint sh_prog = glCreateProgram();
+    glAttachShader(sh_prog, sh_vert);
+    glAttachShader(sh_prog, sh_frag);
 
-#elif __WIN32__
+    if(cached)
+        glProgramParameteri(sh_prog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
-    fprintf(stdout, "[ WARN ] Windows support work in progress...\n");
-    
-    return NULL;
+    glLinkProgram(sh_prog);
 
-#elif
-    
-    fprintf(stderr, "[ ERR ] Undefined platform\n");
+    glDetachShader(sh_prog, sh_vert);
+    glDetachShader(sh_prog, sh_frag);
+    glDeleteShader(sh_vert);
+    glDeleteShader(sh_frag);
 
-    return NULL;
+    GLint status = GL_FALSE;
+    glGetProgramiv(sh_prog, GL_LINK_STATUS, &status);
+    if(status != GL_TRUE) {
+        char log[1024] = { 0 };
+        glGetProgramInfoLog(sh_prog, sizeof(log), NULL, log);
+        fprintf(stdout, "[ ERR ] GLSL: Could not link the \"%s\" program:\n%s\n", variant, log);
 
-#endif
+        glDeleteProgram(sh_prog);
 
-}
+        return 0;
+    }
 
-// ------------------------------
-// SECTION: Functions - Texturing
-// ------------------------------
+    if(cached)
+        ft_shader_cache_save(path, hash, sh_prog);
 
-t_tex2d ft_tex2d(int w, int h, char* data) {
-    t_tex2d tex = { 
-        .w = w,
-        .h = h,
-        .ch = 4
+    return sh_prog;
+}
+
+unsigned long long ft_shader_hash(const char* vert, const char* frag, const char* variant) {
+    // The program binary is only valid for the exact same sources and the exact same driver,
+    // so all of them take part in the key (FNV-1a, 64-bit; the null-terminators act as separators)
+    const char* keys[] = {
+        vert,
+        frag,
+        variant,
+        (const char*) glGetString(GL_VENDOR),
+        (const char*) glGetString(GL_RENDERER),
+        (const char*) glGetString(GL_VERSION)
     };
 
-    glGenTextures(1, &tex.id);
-    glBindTexture(GL_TEXTURE_2D, tex.id);
+    unsigned long long hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+        const char* key = keys[i] ? keys[i] : "";
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        do {
+            hash ^= (unsigned char) *key;
+            hash *= 1099511628211ULL;
+        } while(*key++);
+    }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    return hash;
+}
 
-    glTexImage2D(
-        GL_TEXTURE_2D,
-        0,
-        GL_RGBA,
-        w,
-        h,
-        0,
-        GL_RGBA,
-        GL_UNSIGNED_BYTE,
-        data
-    );
+int ft_shader_cache_path(const char* variant, char* dest, size_t size) {
+    // Programs are unusable from the cache if the driver doesn't support any binary format
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if(formats <= 0)
+        return 0;
 
-    glGenerateMipmap(GL_TEXTURE_2D);
+    char dir[896] = { 0 };
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+#ifdef __linux__
 
-    return tex;
-}
+    // Following the XDG Base Directory specification: $XDG_CACHE_HOME/zoomer, or $HOME/.cache/zoomer as a fallback
+    const char* xdg_cache = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
 
-int ft_draw_tex2d(t_tex2d tex, vec2 position, vec2 size) {
-    // Due to the nature of the application I'm not implementing render batching
-    // This program is simple, it only needs to have a one thing drawn to the screen
-    // Due to this reason there's no need for render batching
-    GLfloat vertices[] = {
-        position[0], position[1],                       0.0f,     1.0f, 1.0f, 1.0f, 1.0f,     0.0f, 0.0f,   tex.id, // Vert: 0
-        position[0] + size[0], position[1],             0.0f,     1.0f, 1.0f, 1.0f, 1.0f,     1.0f, 0.0f,   tex.id, // Vert: 1
-        position[0], position[1] + size[1],             0.0f,     1.0f, 1.0f, 1.0f, 1.0f,     0.0f, 1.0f,   tex.id, // Vert: 2
-        position[0] + size[0], position[1] + size[1],   0.0f,     1.0f, 1.0f, 1.0f, 1.0f,     1.0f, 1.0f,   tex.id, // Vert: 3
-    };
+    if(xdg_cache && *xdg_cache)
+        snprintf(dir, sizeof(dir), "%s", xdg_cache);
+    else if(home && *home)
+        snprintf(dir, sizeof(dir), "%s/.cache", home);
+    else
+        return 0;
 
-    GLuint indices[] = {
-        0, 1, 2,
-        1, 2, 3
-    };
+    mkdir(dir, 0755);
+    strncat(dir, "/zoomer", sizeof(dir) - strlen(dir) - 1);
+    if(mkdir(dir, 0755) != 0 && errno != EEXIST)
+        return 0;
 
-    GLuint vert_arr;
-    glGenVertexArrays(1, &vert_arr);
-    glBindVertexArray(vert_arr);
+#elif __WIN32__
 
-    GLuint vert_buf;
-    glGenBuffers(1, &vert_buf);
-    glBindBuffer(GL_ARRAY_BUFFER, vert_buf);
+    const char* local_app_data = getenv("LOCALAPPDATA");
+    if(!local_app_data || !*local_app_data)
+        return 0;
 
-    GLuint elem_buf;
-    glGenBuffers(1, &elem_buf);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elem_buf);
+    snprintf(dir, sizeof(dir), "%s\\zoomer", local_app_data);
+    if(!CreateDirectoryA(dir, NULL) && GetLastError() != ERROR_ALREADY_EXISTS)
+        return 0;
 
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+#else
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 10 * sizeof(GLfloat), (void*) (0 * sizeof(GLfloat)));
-    
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 10 * sizeof(GLfloat), (void*) (3 * sizeof(GLfloat)));
+    return 0;
 
-    glEnableVertexAttribArray(2);
+#endif
+
+    // One file per variant: a binary built from the older sources (or by the older driver) fails the hash check on load
+    // and gets overwritten by the freshly linked program, so the stale binaries don't pile up
+    return snprintf(dest, size, "%s/%s.bin", dir, variant) < (int) size;
+}
+
+unsigned int ft_shader_cache_load(const char* path, unsigned long long hash) {
+    FILE* file = fopen(path, "rb");
+    if(!file)
+        return 0;
+
+    t_shcache_header header = { 0 };
+    if(fread(&header, sizeof(header), 1, file) != 1 || header.magic != ZOOMER_SHADER_CACHE_MAGIC || header.hash != hash || !header.size) {
+        fclose(file);
+
+        return 0;
+    }
+
+    // The size is only trusted if the file actually holds that many bytes (the file might be truncated or corrupted)
+    long offset = ftell(file);
+    if(fseek(file, 0, SEEK_END) != 0 || ftell(file) - offset != (long) header.size || fseek(file, offset, SEEK_SET) != 0) {
+        fclose(file);
+
+        return 0;
+    }
+
+    void* data = malloc(header.size);
+    if(!data || fread(data, header.size, 1, file) != 1) {
+        free(data);
+        fclose(file);
+
+        return 0;
+    }
+
+    fclose(file);
+
+    // The driver is allowed to reject a binary at any time (i.e. after an update), in which case the link status is false
+    GLuint sh_prog = glCreateProgram();
+    glProgramBinary(sh_prog, header.format, data, header.size);
+    free(data);
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(sh_prog, GL_LINK_STATUS, &status);
+    if(status != GL_TRUE) {
+        glDeleteProgram(sh_prog);
+
+        return 0;
+    }
+
+    return sh_prog;
+}
+
+int ft_shader_cache_save(const char* path, unsigned long long hash, unsigned int prog) {
+    GLint size = 0;
+    glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH, &size);
+    if(size <= 0)
+        return 0;
+
+    void* data = malloc(size);
+    if(!data)
+        return 0;
+
+    t_shcache_header header = {
+        .magic = ZOOMER_SHADER_CACHE_MAGIC,
+        .hash = hash
+    };
+
+    GLsizei length = 0;
+    GLenum format = 0;
+    glGetProgramBinary(prog, size, &length, &format, data);
+
+    header.format = format;
+    header.size = length;
+
+    // Writing to the temporary file first, so that the other instance never reads a half-written binary
+    char path_tmp[1040] = { 0 };
+    snprintf(path_tmp, sizeof(path_tmp), "%s.tmp", path);
+
+    FILE* file = fopen(path_tmp, "wb");
+    if(!file) {
+        free(data);
+
+        return 0;
+    }
+
+    int result =
+        length > 0 &&
+        fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(data, length, 1, file) == 1;
+
+    fclose(file);
+    free(data);
+
+    remove(path);
+    if(!result || rename(path_tmp, path) != 0) {
+        fprintf(stdout, "[ WARN ] GLSL: Could not write the program cache: %s\n", path);
+        remove(path_tmp);
+
+        return 0;
+    }
+
+    return 1;
+}
+
+// -----------------------------------
+// SECTION: Functions - Screen Capture
+// -----------------------------------
+
+char* ft_screen_capture(int w, int h, t_tex2d* tex) {
+
+#ifdef __linux__
+
+    #if ZOOMER_CAPTURE_XCB
+        return ft_screen_capture_xcb(w, h, tex);
+    #else
+        return ft_screen_capture_xlib(w, h, tex);
+    #endif
+
+#elif __WIN32__
+
+    fprintf(stdout, "[ WARN ] Windows support work in progress...\n");
+    
+    return NULL;
+
+#elif
+    
+    fprintf(stderr, "[ ERR ] Undefined platform\n");
+
+    return NULL;
+
+#endif
+
+}
+
+#ifdef __linux__
+
+char* ft_screen_capture_xlib(int w, int h, t_tex2d* tex) {
+    // Get the default displays "display" and "root"
+    Display* x_display = XOpenDisplay(NULL);
+    if(!x_display) {
+        fprintf(stdout, "[ ERR ] X11: Could not open the display\n");
+
+        return NULL;
+    }
+
+    Window x_root = DefaultRootWindow(x_display);
+    
+    // Create an XImage of the screen, with the offset 0-0 and the size 1920-1080
+    XImage* x_image = XGetImage(
+        x_display, x_root,
+        0, 0,
+        w, h,
+        AllPlanes,
+        ZPixmap
+    );
+
+    if(!x_image) {
+        fprintf(stdout, "[ ERR ] X11: Could not create an X11 Image\n");
+
+        XCloseDisplay(x_display);
+
+        return NULL;
+    }
+
+    // Allocate enough memory to fit in 1920-1080 image. Every color consists of 4 channels, so we need to multiply the output by 4
+    char* data = (char*) calloc(w * h * 4, sizeof(char));
+    if(!data) {
+        fprintf(stderr, "[ ERR ] X11: %s\n", strerror(errno));
+
+        XDestroyImage(x_image);
+        XCloseDisplay(x_display);
+
+        return NULL;
+    }
+
+    // Copy all the bytes from the image to the "data" array (and upload them, if there's a texture)
+    ft_bgra_to_rgba(data, x_image->data, w * h);
+    if(tex)
+        ft_tex2d_update_rec(*tex, 0, 0, w, h, data);
+    
+    // Clean-up
+    XDestroyImage(x_image);
+    XCloseDisplay(x_display);
+
+    return data;
+}
+
+char* ft_screen_capture_xcb(int w, int h, t_tex2d* tex) {
+    int screen_num = 0;
+    xcb_connection_t* connection = xcb_connect(NULL, &screen_num);
+    if(xcb_connection_has_error(connection)) {
+        fprintf(stdout, "[ ERR ] XCB: Could not connect to the X server\n");
+
+        xcb_disconnect(connection);
+
+        return NULL;
+    }
+
+    // The preferred screen of the display (i.e. ':0.1'), the same one the Xlib path gets from 'DefaultRootWindow'
+    xcb_screen_iterator_t screen_iter = xcb_setup_roots_iterator(xcb_get_setup(connection));
+    for(int i = 0; i < screen_num && screen_iter.rem; i++)
+        xcb_screen_next(&screen_iter);
+
+    xcb_screen_t* screen = screen_iter.data;
+
+    int tiles = (h + ZOOMER_CAPTURE_TILE - 1) / ZOOMER_CAPTURE_TILE;
+    char* data = (char*) calloc(w * h * 4, sizeof(char));
+    xcb_get_image_cookie_t* cookies = (xcb_get_image_cookie_t*) malloc(tiles * sizeof(xcb_get_image_cookie_t));
+    if(!data || !cookies) {
+        fprintf(stderr, "[ ERR ] XCB: %s\n", strerror(errno));
+
+        free(data);
+        free(cookies);
+        xcb_disconnect(connection);
+
+        return NULL;
+    }
+
+    // The screen is split into horizontal tiles and all the requests are sent up front,
+    // so the X server keeps transferring the next tiles while we're converting the previous ones
+    for(int i = 0; i < tiles; i++) {
+        int y = i * ZOOMER_CAPTURE_TILE;
+        int tile_h = h - y < ZOOMER_CAPTURE_TILE ? h - y : ZOOMER_CAPTURE_TILE;
+
+        cookies[i] = xcb_get_image(
+            connection,
+            XCB_IMAGE_FORMAT_Z_PIXMAP,
+            screen->root,
+            0, y,
+            w, tile_h,
+            ~0u
+        );
+    }
+
+    xcb_flush(connection);
+
+    // The replies are collected in order, every one of them is converted and uploaded as soon as it arrives.
+    // If a tile fails we still need to collect the rest of the replies, so the loop doesn't break early
+    int result = 1;
+    for(int i = 0; i < tiles; i++) {
+        int y = i * ZOOMER_CAPTURE_TILE;
+        int tile_h = h - y < ZOOMER_CAPTURE_TILE ? h - y : ZOOMER_CAPTURE_TILE;
+
+        xcb_generic_error_t* error = NULL;
+        xcb_get_image_reply_t* reply = xcb_get_image_reply(connection, cookies[i], &error);
+        if(!reply) {
+            if(result)
+                fprintf(stdout, "[ ERR ] XCB: Could not get the image of the tile %d (error code: %d)\n", i, error ? error->error_code : -1);
+
+            free(error);
+            result = 0;
+
+            continue;
+        }
+
+        // X11 internally uses 32 bits per pixel (BGRA byte order) for the 24-bit and 32-bit visuals
+        if(result && xcb_get_image_data_length(reply) >= w * tile_h * 4) {
+            ft_bgra_to_rgba(data + (size_t) y * w * 4, (const char*) xcb_get_image_data(reply), w * tile_h);
+
+            if(tex)
+                ft_tex2d_update_rec(*tex, 0, y, w, tile_h, data + (size_t) y * w * 4);
+        } else if(result) {
+            fprintf(stdout, "[ ERR ] XCB: Unsupported pixel format (depth: %d)\n", reply->depth);
+
+            result = 0;
+        }
+
+        free(reply);
+    }
+
+    // Clean-up
+    free(cookies);
+    xcb_disconnect(connection);
+
+    if(!result) {
+        free(data);
+
+        return NULL;
+    }
+
+    return data;
+}
+
+int ft_screen_capture_bench(int iterations) {
+    Display* x_display = XOpenDisplay(NULL);
+    if(!x_display) {
+        fprintf(stdout, "[ ERR ] X11: Could not open the display\n");
+
+        return 0;
+    }
+
+    // Benchmarking the capture of the whole screen (the larger the screen, the more the tiling pays off)
+    int w = DisplayWidth(x_display, DefaultScreen(x_display));
+    int h = DisplayHeight(x_display, DefaultScreen(x_display));
+    XCloseDisplay(x_display);
+
+    iterations = iterations > 0 ? iterations : 1;
+
+    // The upload is a part of the benchmark, so we need the GL context (the window is never shown)
+    int gl = ft_init(w, h, "Zoomer | Benchmark");
+    if(!gl)
+        fprintf(stdout, "[ WARN ] Capture: Could not initialize OpenGL, benchmarking without the texture upload\n");
+
+    t_tex2d tex = { 0 };
+    if(gl)
+        tex = ft_tex2d(w, h, NULL);
+
+    const char* names[] = { "Xlib", "XCB" };
+    char* (*backends[])(int, int, t_tex2d*) = { ft_screen_capture_xlib, ft_screen_capture_xcb };
+    char* results[2] = { 0 };
+    int result = 1;
+
+    for(int i = 0; i < 2 && result; i++) {
+        double time_min = 0.0;
+        double time_sum = 0.0;
+
+        for(int j = 0; j < iterations; j++) {
+            Uint64 time_begin = SDL_GetPerformanceCounter();
+            char* data = backends[i](w, h, gl ? &tex : NULL);
+
+            // The time ends once the driver has actually consumed all the uploads
+            if(gl)
+                glFinish();
+
+            double time = (double) (SDL_GetPerformanceCounter() - time_begin) * 1000.0 / SDL_GetPerformanceFrequency();
+
+            if(!data) {
+                result = 0;
+
+                break;
+            }
+
+            time_min = j == 0 || time < time_min ? time : time_min;
+            time_sum += time;
+
+            free(results[i]);
+            results[i] = data;
+        }
+
+        if(result)
+            fprintf(stdout, "[ INFO ] Capture%s: %-4s %dx%d, %d iterations, avg: %.3f ms, min: %.3f ms\n", gl ? " + upload" : "", names[i], w, h, iterations, time_sum / iterations, time_min);
+    }
+
+    if(result && memcmp(results[0], results[1], (size_t) w * h * 4) != 0)
+        fprintf(stdout, "[ WARN ] Capture: Xlib and XCB images differ (did the screen change during the benchmark?)\n");
+
+    free(results[0]);
+    free(results[1]);
+
+    if(gl) {
+        glDeleteTextures(1, &tex.id);
+        ft_quit();
+    }
+
+    return result;
+}
+
+#endif // __linux__
+
+int ft_bgra_to_rgba(char* dest, const char* src, int count) {
+    // X11 internally uses BGRA byte order, so we need to shift the values to the RGBA order
+    for(int i = 0; i < count * 4; i += 4) {
+        dest[i + 0] = src[i + 2];
+        dest[i + 1] = src[i + 1];
+        dest[i + 2] = src[i + 0];
+        dest[i + 3] = src[i + 3];
+    }
+
+    return 1;
+}
+
+// ------------------------------
+// SECTION: Functions - Texturing
+// ------------------------------
+
+t_tex2d ft_tex2d(int w, int h, char* data) {
+    t_tex2d tex = { 
+        .w = w,
+        .h = h,
+        .ch = 4
+    };
+
+    glGenTextures(1, &tex.id);
+    glBindTexture(GL_TEXTURE_2D, tex.id);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glTexImage2D(
+        GL_TEXTURE_2D,
+        0,
+        GL_RGBA,
+        w,
+        h,
+        0,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        data
+    );
+
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return tex;
+}
+
+int ft_tex2d_update(t_tex2d tex, char* data) {
+    ft_tex2d_update_rec(tex, 0, 0, tex.w, tex.h, data);
+
+    glBindTexture(GL_TEXTURE_2D, tex.id);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return 1;
+}
+
+int ft_tex2d_update_rec(t_tex2d tex, int x, int y, int w, int h, char* data) {
+    // Updating only the part of the texture (the data is tightly packed: 'w' pixels per row)
+    glBindTexture(GL_TEXTURE_2D, tex.id);
+
+    glTexSubImage2D(
+        GL_TEXTURE_2D,
+        0,
+        x,
+        y,
+        w,
+        h,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        data
+    );
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return 1;
+}
+
+int ft_draw_tex2d(t_tex2d tex, vec2 position, vec2 size) {
+    return ft_draw_quad(tex.id, position, size, (vec4) { 1.0f, 1.0f, 1.0f, 1.0f });
+}
+
+int ft_draw_quad(unsigned int tex_id, vec2 position, vec2 size, vec4 color) {
+    // This function draws one-off textured quads (the screen capture),
+    // so it's not batched: every call creates and destroys its own vertex array and buffers
+    // Everything else (the pixel grid, crosshair, rulers and the whole inspector) goes through the overlay batch (see: ft_overlay_begin)
+    GLfloat vertices[] = {
+        position[0], position[1],                       0.0f,     color[0], color[1], color[2], color[3],     0.0f, 0.0f,   tex_id, // Vert: 0
+        position[0] + size[0], position[1],             0.0f,     color[0], color[1], color[2], color[3],     1.0f, 0.0f,   tex_id, // Vert: 1
+        position[0], position[1] + size[1],             0.0f,     color[0], color[1], color[2], color[3],     0.0f, 1.0f,   tex_id, // Vert: 2
+        position[0] + size[0], position[1] + size[1],   0.0f,     color[0], color[1], color[2], color[3],     1.0f, 1.0f,   tex_id, // Vert: 3
+    };
+
+    GLuint indices[] = {
+        0, 1, 2,
+        1, 2, 3
+    };
+
+    GLuint vert_arr;
+    glGenVertexArrays(1, &vert_arr);
+    glBindVertexArray(vert_arr);
+
+    GLuint vert_buf;
+    glGenBuffers(1, &vert_buf);
+    glBindBuffer(GL_ARRAY_BUFFER, vert_buf);
+
+    GLuint elem_buf;
+    glGenBuffers(1, &elem_buf);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elem_buf);
+
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 10 * sizeof(GLfloat), (void*) (0 * sizeof(GLfloat)));
+    
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 10 * sizeof(GLfloat), (void*) (3 * sizeof(GLfloat)));
+
+    glEnableVertexAttribArray(2);
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 10 * sizeof(GLfloat), (void*) (7 * sizeof(GLfloat)));
  
     glEnableVertexAttribArray(3);
     glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 10 * sizeof(GLfloat), (void*) (9 * sizeof(GLfloat)));
 
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, tex.id);
+    glBindTexture(GL_TEXTURE_2D, tex_id);
+
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+
+    glDeleteBuffers(1, &vert_buf);
+    glDeleteBuffers(1, &elem_buf);
+    glDeleteVertexArrays(1, &vert_arr);
+
+    return 1;
+}
+
+// ----------------------------
+// SECTION: Functions - Overlay
+// ----------------------------
+
+int ft_overlay_init(void) {
+    t_overlay* ov = &CORE.overlay;
+
+    ov->sh_prog = ft_shader_program(glsl_overlay_vert, glsl_overlay_frag, "overlay");
+    if(!ov->sh_prog)
+        return 0;
+
+    // Unlike 'ft_draw_quad', the vertex array and the vertex buffer live for the whole program
+    // Every frame only re-uploads the vertices into the same (orphaned) buffer
+    glGenVertexArrays(1, &ov->vert_arr);
+    glBindVertexArray(ov->vert_arr);
+
+    glGenBuffers(1, &ov->vert_buf);
+    glBindBuffer(GL_ARRAY_BUFFER, ov->vert_buf);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ov->vertices), NULL, GL_STREAM_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, ZOOMER_OVERLAY_STRIDE * sizeof(GLfloat), (void*) (0 * sizeof(GLfloat)));
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, ZOOMER_OVERLAY_STRIDE * sizeof(GLfloat), (void*) (2 * sizeof(GLfloat)));
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, ZOOMER_OVERLAY_STRIDE * sizeof(GLfloat), (void*) (6 * sizeof(GLfloat)));
+
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, ZOOMER_OVERLAY_STRIDE * sizeof(GLfloat), (void*) (8 * sizeof(GLfloat)));
+
+    glBindVertexArray(0);
+
+    // The glyphs are rasterized into the atlas once, the rest of it is filled by the inspector (see: ft_overlay_atlas)
+    char* atlas_data = calloc(ZOOMER_ATLAS_W * ZOOMER_ATLAS_H * 4, 1);
+    if(!atlas_data) {
+        fprintf(stdout, "[ ERR ] Failed to allocate the overlay atlas\n");
+        return 0;
+    }
+
+    ft_raster_text(atlas_data, ZOOMER_ATLAS_W, ZOOMER_ATLAS_H, ZOOMER_ATLAS_FONT_X, ZOOMER_ATLAS_FONT_Y, ZOOMER_ATLAS_FONT);
+    ov->atlas = ft_tex2d(ZOOMER_ATLAS_W, ZOOMER_ATLAS_H, atlas_data);
+    free(atlas_data);
+
+    return 1;
+}
+
+int ft_overlay_quit(void) {
+    t_overlay* ov = &CORE.overlay;
+
+    glDeleteTextures(1, &ov->atlas.id);
+    glDeleteBuffers(1, &ov->vert_buf);
+    glDeleteVertexArrays(1, &ov->vert_arr);
+    glDeleteProgram(ov->sh_prog);
+
+    return 1;
+}
+
+int ft_overlay_begin(void) {
+    CORE.overlay.count = 0;
+
+    return 1;
+}
+
+int ft_overlay_end(void) {
+    t_overlay* ov = &CORE.overlay;
+    if(!ov->count)
+        return 1;
+
+    mat4 mat_proj = GLM_MAT4_IDENTITY_INIT;
+    glm_ortho(0.0f, ZOOMER_DISPLAY_WIDTH, ZOOMER_DISPLAY_HEIGHT, 0.0f, -1.0f, 1.0f, mat_proj);
+
+    glUseProgram(ov->sh_prog);
+    glUniformMatrix4fv(glGetUniformLocation(ov->sh_prog, "u_proj"), 1, GL_FALSE, &mat_proj[0][0]);
+    glUniform1i(glGetUniformLocation(ov->sh_prog, "u_Texture"), 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, ov->atlas.id);
 
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    glBindVertexArray(ov->vert_arr);
+    glBindBuffer(GL_ARRAY_BUFFER, ov->vert_buf);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ov->vertices), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, ov->count * ZOOMER_OVERLAY_STRIDE * sizeof(GLfloat), ov->vertices);
 
-    glDeleteBuffers(1, &vert_buf);
-    glDeleteBuffers(1, &elem_buf);
-    glDeleteVertexArrays(1, &vert_arr);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glDrawArrays(GL_TRIANGLES, 0, ov->count);
+
+    glDisable(GL_BLEND);
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(CORE.sh_prog);
+
+    ov->count = 0;
+
+    return 1;
+}
+
+int ft_overlay_vertex(float x, float y, vec4 color, float world_x, float world_y, float kind) {
+    t_overlay* ov = &CORE.overlay;
+    if(ov->count >= ZOOMER_OVERLAY_VERTICES)
+        return 0;
+
+    float* vertex = ov->vertices + ov->count * ZOOMER_OVERLAY_STRIDE;
+    vertex[0] = x;
+    vertex[1] = y;
+    vertex[2] = color[0];
+    vertex[3] = color[1];
+    vertex[4] = color[2];
+    vertex[5] = color[3];
+    vertex[6] = world_x;
+    vertex[7] = world_y;
+    vertex[8] = kind;
+
+    ov->count++;
+
+    return 1;
+}
+
+int ft_overlay_quad(vec2 position, vec2 size, vec4 color, float kind, vec2 world[4]) {
+    // Quads are pushed whole or not at all
+    if(CORE.overlay.count + 6 > ZOOMER_OVERLAY_VERTICES)
+        return 0;
+
+    // Corners: 0 - top-left, 1 - top-right, 2 - bottom-left, 3 - bottom-right
+    float x0 = position[0];
+    float y0 = position[1];
+    float x1 = position[0] + size[0];
+    float y1 = position[1] + size[1];
+
+    ft_overlay_vertex(x0, y0, color, world[0][0], world[0][1], kind);
+    ft_overlay_vertex(x1, y0, color, world[1][0], world[1][1], kind);
+    ft_overlay_vertex(x0, y1, color, world[2][0], world[2][1], kind);
+    ft_overlay_vertex(x1, y0, color, world[1][0], world[1][1], kind);
+    ft_overlay_vertex(x0, y1, color, world[2][0], world[2][1], kind);
+    ft_overlay_vertex(x1, y1, color, world[3][0], world[3][1], kind);
+
+    return 1;
+}
+
+int ft_overlay_rec(vec2 position, vec2 size, vec4 color) {
+    vec2 world[4] = { 0 };
+
+    return ft_overlay_quad(position, size, color, 0.0f, world);
+}
+
+int ft_overlay_line(vec2 begin, vec2 end, float thickness, vec4 color) {
+    if(CORE.overlay.count + 6 > ZOOMER_OVERLAY_VERTICES)
+        return 0;
+
+    // The line is a quad extruded along the normal by the half of its thickness
+    vec2 dir = { end[0] - begin[0], end[1] - begin[1] };
+    float len = sqrtf(dir[0] * dir[0] + dir[1] * dir[1]);
+    if(len == 0.0f)
+        return 0;
+
+    vec2 normal = { -dir[1] / len * thickness * 0.5f, dir[0] / len * thickness * 0.5f };
+
+    ft_overlay_vertex(begin[0] + normal[0], begin[1] + normal[1], color, 0.0f, 0.0f, 0.0f);
+    ft_overlay_vertex(end[0] + normal[0], end[1] + normal[1], color, 0.0f, 0.0f, 0.0f);
+    ft_overlay_vertex(begin[0] - normal[0], begin[1] - normal[1], color, 0.0f, 0.0f, 0.0f);
+    ft_overlay_vertex(end[0] + normal[0], end[1] + normal[1], color, 0.0f, 0.0f, 0.0f);
+    ft_overlay_vertex(begin[0] - normal[0], begin[1] - normal[1], color, 0.0f, 0.0f, 0.0f);
+    ft_overlay_vertex(end[0] - normal[0], end[1] - normal[1], color, 0.0f, 0.0f, 0.0f);
+
+    return 1;
+}
+
+int ft_overlay_tex(vec2 position, vec2 size, vec4 color, int src[4]) {
+    // 'src' is the rectangle (in pixels) of the overlay atlas, it's passed to the shader as the normalized texture coordinates
+    float u0 = (float) src[0] / ZOOMER_ATLAS_W;
+    float v0 = (float) src[1] / ZOOMER_ATLAS_H;
+    float u1 = (float) (src[0] + src[2]) / ZOOMER_ATLAS_W;
+    float v1 = (float) (src[1] + src[3]) / ZOOMER_ATLAS_H;
+
+    vec2 world[4] = { { u0, v0 }, { u1, v0 }, { u0, v1 }, { u1, v1 } };
+    return ft_overlay_quad(position, size, color, 3.0f, world);
+}
+
+int ft_overlay_text(vec2 position, const char* text, vec4 color) {
+    // One quad per glyph, snapped to the whole pixels so the (nearest-sampled) glyphs stay sharp
+    float x = floorf(position[0]);
+    float y = floorf(position[1]);
+
+    for(; *text; text++, x += 6.0f) {
+        const char* glyph = strchr(ZOOMER_ATLAS_FONT, *text);
+        if(!glyph)
+            continue;
+
+        int src[4] = { ZOOMER_ATLAS_FONT_X + (int) (glyph - ZOOMER_ATLAS_FONT) * 6, ZOOMER_ATLAS_FONT_Y, 5, 7 };
+        if(!ft_overlay_tex((vec2) { x, y }, (vec2) { 5.0f, 7.0f }, color, src))
+            return 0;
+    }
+
+    return 1;
+}
+
+int ft_overlay_atlas(int x, int y, int w, int h, char* data) {
+    // The atlas is only ever magnified, so the mipmaps aren't regenerated
+    return ft_tex2d_update_rec(CORE.overlay.atlas, x, y, w, h, data);
+}
+
+int ft_overlay_grid(t_cam2d cam, vec2 size) {
+    // A single quad covering the whole image, the grid lines are generated in the fragment shader
+    vec2 begin;
+    vec2 end;
+    ft_world_to_screen(cam, (vec2) { 0.0f, 0.0f }, begin);
+    ft_world_to_screen(cam, size, end);
+
+    vec2 world[4] = {
+        { 0.0f, 0.0f },
+        { size[0], 0.0f },
+        { 0.0f, size[1] },
+        { size[0], size[1] }
+    };
+
+    return ft_overlay_quad(begin, (vec2) { end[0] - begin[0], end[1] - begin[1] }, (vec4) { 0.5f, 0.5f, 0.5f, 0.5f }, 1.0f, world);
+}
+
+int ft_overlay_crosshair(t_cam2d cam) {
+    vec2 mouse_pos_world;
+    ft_screen_to_world(cam, CORE.mouse_pos, mouse_pos_world);
+
+    // Snapping the crosshair to the pixel under the cursor
+    vec2 pixel_begin;
+    vec2 pixel_end;
+    ft_world_to_screen(cam, (vec2) { floorf(mouse_pos_world[0]), floorf(mouse_pos_world[1]) }, pixel_begin);
+    ft_world_to_screen(cam, (vec2) { floorf(mouse_pos_world[0]) + 1.0f, floorf(mouse_pos_world[1]) + 1.0f }, pixel_end);
+
+    vec2 center = {
+        (pixel_begin[0] + pixel_end[0]) * 0.5f,
+        (pixel_begin[1] + pixel_end[1]) * 0.5f
+    };
+
+    vec4 color_line = { 1.0f, 1.0f, 1.0f, 0.5f };
+    vec4 color_box = { 1.0f, 0.2f, 0.2f, 1.0f };
+
+    ft_overlay_line((vec2) { 0.0f, center[1] }, (vec2) { pixel_begin[0], center[1] }, 1.0f, color_line);
+    ft_overlay_line((vec2) { pixel_end[0], center[1] }, (vec2) { ZOOMER_DISPLAY_WIDTH, center[1] }, 1.0f, color_line);
+    ft_overlay_line((vec2) { center[0], 0.0f }, (vec2) { center[0], pixel_begin[1] }, 1.0f, color_line);
+    ft_overlay_line((vec2) { center[0], pixel_end[1] }, (vec2) { center[0], ZOOMER_DISPLAY_HEIGHT }, 1.0f, color_line);
+
+    ft_overlay_line((vec2) { pixel_begin[0], pixel_begin[1] }, (vec2) { pixel_end[0], pixel_begin[1] }, 2.0f, color_box);
+    ft_overlay_line((vec2) { pixel_begin[0], pixel_end[1] }, (vec2) { pixel_end[0], pixel_end[1] }, 2.0f, color_box);
+    ft_overlay_line((vec2) { pixel_begin[0], pixel_begin[1] }, (vec2) { pixel_begin[0], pixel_end[1] }, 2.0f, color_box);
+    ft_overlay_line((vec2) { pixel_end[0], pixel_begin[1] }, (vec2) { pixel_end[0], pixel_end[1] }, 2.0f, color_box);
+
+    return 1;
+}
+
+int ft_overlay_rulers(t_cam2d cam) {
+    vec2 screen_begin;
+    vec2 screen_end;
+    ft_screen_to_world(cam, (vec2) { 0.0f, 0.0f }, screen_begin);
+    ft_screen_to_world(cam, (vec2) { ZOOMER_DISPLAY_WIDTH, ZOOMER_DISPLAY_HEIGHT }, screen_end);
+
+    vec4 color_bg = { 0.1f, 0.1f, 0.1f, 0.85f };
+    vec4 color_tick = { 0.9f, 0.9f, 0.9f, 1.0f };
+    vec4 color_mouse = { 1.0f, 0.2f, 0.2f, 1.0f };
+
+    // The world coordinates of the ruler are: x - the coordinate along the ruler, y - the distance from the outer edge (0.0f - 1.0f)
+    vec2 world_top[4] = {
+        { screen_begin[0], 0.0f },
+        { screen_end[0], 0.0f },
+        { screen_begin[0], 1.0f },
+        { screen_end[0], 1.0f }
+    };
+
+    vec2 world_left[4] = {
+        { screen_begin[1], 0.0f },
+        { screen_begin[1], 1.0f },
+        { screen_end[1], 0.0f },
+        { screen_end[1], 1.0f }
+    };
+
+    ft_overlay_rec((vec2) { 0.0f, 0.0f }, (vec2) { ZOOMER_DISPLAY_WIDTH, ZOOMER_RULER_SIZE }, color_bg);
+    ft_overlay_rec((vec2) { 0.0f, ZOOMER_RULER_SIZE }, (vec2) { ZOOMER_RULER_SIZE, ZOOMER_DISPLAY_HEIGHT - ZOOMER_RULER_SIZE }, color_bg);
+
+    ft_overlay_quad((vec2) { 0.0f, 0.0f }, (vec2) { ZOOMER_DISPLAY_WIDTH, ZOOMER_RULER_SIZE }, color_tick, 2.0f, world_top);
+    ft_overlay_quad((vec2) { 0.0f, 0.0f }, (vec2) { ZOOMER_RULER_SIZE, ZOOMER_DISPLAY_HEIGHT }, color_tick, 2.0f, world_left);
+
+    // Labels of the major ticks (every 10th pixel), right of the tick on the top ruler and below it on the left one
+    char label[16];
+    for(float x = ceilf(screen_begin[0] / 10.0f) * 10.0f; x < screen_end[0]; x += 10.0f) {
+        vec2 pos;
+        ft_world_to_screen(cam, (vec2) { x, 0.0f }, pos);
+
+        snprintf(label, sizeof(label), "%d", (int) x);
+        ft_overlay_text((vec2) { pos[0] + 3.0f, 3.0f }, label, color_tick);
+    }
+
+    for(float y = ceilf(screen_begin[1] / 10.0f) * 10.0f; y < screen_end[1]; y += 10.0f) {
+        vec2 pos;
+        ft_world_to_screen(cam, (vec2) { 0.0f, y }, pos);
+
+        snprintf(label, sizeof(label), "%d", (int) y);
+        ft_overlay_text((vec2) { 3.0f, pos[1] + 3.0f }, label, color_tick);
+    }
+
+    // Cursor position markers
+    ft_overlay_rec((vec2) { CORE.mouse_pos[0] - 1.0f, 0.0f }, (vec2) { 2.0f, ZOOMER_RULER_SIZE }, color_mouse);
+    ft_overlay_rec((vec2) { 0.0f, CORE.mouse_pos[1] - 1.0f }, (vec2) { ZOOMER_RULER_SIZE, 2.0f }, color_mouse);
+
+    // The corner where both of the rulers meet
+    ft_overlay_rec((vec2) { 0.0f, 0.0f }, (vec2) { ZOOMER_RULER_SIZE, ZOOMER_RULER_SIZE }, color_bg);
 
     return 1;
 }
@@ -609,6 +1810,14 @@ int ft_mouseup(int button) {
     return !CORE.mouse_button[button];
 }
 
+int ft_mousepress(int button) {
+    return CORE.mouse_button[button] && !CORE.mouse_button_prev[button];
+}
+
+int ft_mouserelease(int button) {
+    return !CORE.mouse_button[button] && CORE.mouse_button_prev[button];
+}
+
 float ft_mousewheel(void) {
     float wheel = 0.0f;
 
@@ -680,6 +1889,26 @@ int ft_screen_to_world(t_cam2d cam, vec2 src, vec2 dest) {
     return 1;
 }
 
+int ft_world_to_screen(t_cam2d cam, vec2 src, vec2 dest) {
+    mat4 mat_cam;
+    ft_cam2d_matrix(cam, mat_cam);
+
+    vec4 trans_mulv;
+    vec4 trans = {
+        src[0],
+        src[1],
+        0.0f,
+        1.0f
+    };
+
+    glm_mat4_mulv(mat_cam, trans, trans_mulv);
+
+    dest[0] = trans_mulv[0];
+    dest[1] = trans_mulv[1];
+
+    return 1;
+}
+
 int ft_cam2d_matrix(t_cam2d cam, mat4 dest) {
     glm_mat4_identity(dest);
 
@@ -726,6 +1955,457 @@ int ft_cam2d_zoom(t_cam2d* cam) {
     return 1;
 }
 
+// ------------------------------
+// SECTION: Functions - Inspector
+// ------------------------------
+
+int ft_inspector_init(t_inspector* insp) {
+    insp->pixel[0] = -1;
+    insp->pixel[1] = -1;
+
+    return 1;
+}
+
+int ft_inspector_update(t_inspector* insp, t_cam2d cam, char* data, int w, int h) {
+    if(!data)
+        return 0;
+
+    vec2 mouse_pos_world;
+    ft_screen_to_world(cam, CORE.mouse_pos, mouse_pos_world);
+
+    // Pixel under the cursor (the readout is re-rasterized only when either the position or the value changes)
+    int readout = 0;
+    int px = (int) floorf(mouse_pos_world[0]);
+    int py = (int) floorf(mouse_pos_world[1]);
+    if(px >= 0 && py >= 0 && px < w && py < h) {
+        const unsigned char* pixel = (const unsigned char*) data + ((size_t) py * w + px) * 4;
+
+        if(px != insp->pixel[0] || py != insp->pixel[1] || memcmp(pixel, insp->color, 4) != 0) {
+            insp->pixel[0] = px;
+            insp->pixel[1] = py;
+            memcpy(insp->color, pixel, 4);
+
+            readout = 1;
+        }
+    }
+
+    // Region selection
+    if(ft_keydown(SDL_SCANCODE_LSHIFT) && ft_mousepress(SDL_BUTTON_LEFT)) {
+        insp->selecting = 1;
+        insp->sel_begin[0] = mouse_pos_world[0];
+        insp->sel_begin[1] = mouse_pos_world[1];
+    }
+
+    if(!insp->selecting) {
+        if(readout)
+            ft_inspector_readout(insp);
+
+        return 1;
+    }
+
+    insp->sel_end[0] = mouse_pos_world[0];
+    insp->sel_end[1] = mouse_pos_world[1];
+
+    // Every pixel touched by the selection is a part of the region
+    int x0 = glm_clamp(floorf(glm_min(insp->sel_begin[0], insp->sel_end[0])), 0.0f, w);
+    int y0 = glm_clamp(floorf(glm_min(insp->sel_begin[1], insp->sel_end[1])), 0.0f, h);
+    int x1 = glm_clamp(floorf(glm_max(insp->sel_begin[0], insp->sel_end[0])) + 1.0f, 0.0f, w);
+    int y1 = glm_clamp(floorf(glm_max(insp->sel_begin[1], insp->sel_end[1])) + 1.0f, 0.0f, h);
+    int rect[4] = { x0, y0, x1 - x0, y1 - y0 };
+
+    // The statistics are recomputed only when the region actually changes
+    if(rect[2] > 0 && rect[3] > 0 && memcmp(rect, insp->rect, sizeof(rect)) != 0) {
+        memcpy(insp->rect, rect, sizeof(rect));
+
+        if(ft_region_stats(insp, data, w, insp->rect, &insp->stats)) {
+            static char hist_data[ZOOMER_INSPECTOR_HIST_W * ZOOMER_INSPECTOR_HIST_H * 4];
+
+            // Square-root scale, so that the dominant color (i.e. the background) doesn't flatten all the others
+            unsigned int peak = 1;
+            for(int c = 0; c < 3; c++)
+                for(int i = 0; i < 256; i++)
+                    peak = insp->stats.histogram[c][i] > peak ? insp->stats.histogram[c][i] : peak;
+
+            for(int x = 0; x < ZOOMER_INSPECTOR_HIST_W; x++) {
+                int bar[3];
+                for(int c = 0; c < 3; c++)
+                    bar[c] = sqrtf((float) insp->stats.histogram[c][x] / peak) * ZOOMER_INSPECTOR_HIST_H;
+
+                for(int y = 0; y < ZOOMER_INSPECTOR_HIST_H; y++) {
+                    char* pixel = hist_data + (y * ZOOMER_INSPECTOR_HIST_W + x) * 4;
+                    int level = ZOOMER_INSPECTOR_HIST_H - 1 - y;
+
+                    pixel[0] = level < bar[0] ? 0xff : 0x20;
+                    pixel[1] = level < bar[1] ? 0xff : 0x20;
+                    pixel[2] = level < bar[2] ? 0xff : 0x20;
+                    pixel[3] = (level < bar[0] || level < bar[1] || level < bar[2]) ? 0xe0 : 0x80;
+                }
+            }
+
+            ft_overlay_atlas(ZOOMER_ATLAS_HIST_X, ZOOMER_ATLAS_HIST_Y, ZOOMER_INSPECTOR_HIST_W, ZOOMER_INSPECTOR_HIST_H, hist_data);
+
+            readout = 1;
+        }
+    }
+
+    if(readout)
+        ft_inspector_readout(insp);
+
+    // The summary of the region is also written to the console once the selection is done (i.e. for copying the values)
+    if(ft_mouserelease(SDL_BUTTON_LEFT)) {
+        t_stats* stats = &insp->stats;
+        insp->selecting = 0;
+
+        fprintf(stdout, "[ INFO ] Region: (%d, %d) %dx%d, %u pixels, %u unique colors\n", insp->rect[0], insp->rect[1], insp->rect[2], insp->rect[3], stats->count, stats->unique);
+        fprintf(stdout, "[ INFO ]   min:  RGBA(%u, %u, %u, %u)\n", stats->min[0], stats->min[1], stats->min[2], stats->min[3]);
+        fprintf(stdout, "[ INFO ]   max:  RGBA(%u, %u, %u, %u)\n", stats->max[0], stats->max[1], stats->max[2], stats->max[3]);
+        fprintf(stdout, "[ INFO ]   mean: RGBA(%.2f, %.2f, %.2f, %.2f)\n", stats->mean[0], stats->mean[1], stats->mean[2], stats->mean[3]);
+    }
+
+    return 1;
+}
+
+int ft_inspector_overlay(t_inspector* insp, t_cam2d cam) {
+    // The selection is stored in the world space, so it has to be projected onto the screen first
+    if(insp->rect[2] > 0 && insp->rect[3] > 0) {
+        vec2 begin;
+        vec2 end;
+        ft_world_to_screen(cam, (vec2) { insp->rect[0], insp->rect[1] }, begin);
+        ft_world_to_screen(cam, (vec2) { insp->rect[0] + insp->rect[2], insp->rect[1] + insp->rect[3] }, end);
+
+        ft_overlay_rec(begin, (vec2) { end[0] - begin[0], end[1] - begin[1] }, (vec4) { 0.2f, 0.5f, 1.0f, 0.25f });
+    }
+
+    if(insp->pixel[0] >= 0) {
+        ft_overlay_rec((vec2) { ZOOMER_RULER_SIZE + 14.0f, ZOOMER_RULER_SIZE + 14.0f }, (vec2) { 36.0f, 36.0f }, (vec4) { 0.0f, 0.0f, 0.0f, 0.8f });
+        ft_overlay_rec((vec2) { ZOOMER_RULER_SIZE + 16.0f, ZOOMER_RULER_SIZE + 16.0f }, (vec2) { 32.0f, 32.0f }, (vec4) { insp->color[0] / 255.0f, insp->color[1] / 255.0f, insp->color[2] / 255.0f, 1.0f });
+
+        // The readout and the histogram live in the overlay atlas, so they're part of the same batch
+        ft_overlay_tex(
+            (vec2) { ZOOMER_RULER_SIZE + 16.0f, ZOOMER_RULER_SIZE + 64.0f },
+            (vec2) { ZOOMER_INSPECTOR_TEXT_W * 2.0f, ZOOMER_INSPECTOR_TEXT_H * 2.0f },
+            (vec4) { 1.0f, 1.0f, 1.0f, 1.0f },
+            (int[4]) { ZOOMER_ATLAS_READOUT_X, ZOOMER_ATLAS_READOUT_Y, ZOOMER_INSPECTOR_TEXT_W, ZOOMER_INSPECTOR_TEXT_H }
+        );
+
+        if(insp->rect[2] > 0 && insp->rect[3] > 0) {
+            ft_overlay_tex(
+                (vec2) { ZOOMER_RULER_SIZE + 16.0f, ZOOMER_RULER_SIZE + 72.0f + ZOOMER_INSPECTOR_TEXT_H * 2.0f },
+                (vec2) { ZOOMER_INSPECTOR_HIST_W * 2.0f, ZOOMER_INSPECTOR_HIST_H },
+                (vec4) { 1.0f, 1.0f, 1.0f, 1.0f },
+                (int[4]) { ZOOMER_ATLAS_HIST_X, ZOOMER_ATLAS_HIST_Y, ZOOMER_INSPECTOR_HIST_W, ZOOMER_INSPECTOR_HIST_H }
+            );
+        }
+    }
+
+    return 1;
+}
+
+int ft_inspector_quit(t_inspector* insp) {
+    for(int i = 0; i < ZOOMER_INSPECTOR_THREADS; i++)
+        free(insp->colors[i]);
+
+    return 1;
+}
+
+int ft_inspector_readout(t_inspector* insp) {
+    static char text_data[ZOOMER_INSPECTOR_TEXT_W * ZOOMER_INSPECTOR_TEXT_H * 4];
+    char line[64];
+
+    // Semi-transparent background, the text is rasterized on top of it
+    for(int i = 0; i < ZOOMER_INSPECTOR_TEXT_W * ZOOMER_INSPECTOR_TEXT_H * 4; i += 4) {
+        text_data[i + 0] = 0x10;
+        text_data[i + 1] = 0x10;
+        text_data[i + 2] = 0x10;
+        text_data[i + 3] = (char) 0xc0;
+    }
+
+    snprintf(line, sizeof(line), "PIXEL %d, %d", insp->pixel[0], insp->pixel[1]);
+    ft_raster_text(text_data, ZOOMER_INSPECTOR_TEXT_W, ZOOMER_INSPECTOR_TEXT_H, 4, 4, line);
+
+    snprintf(line, sizeof(line), "RGBA %u %u %u %u #%02X%02X%02X", insp->color[0], insp->color[1], insp->color[2], insp->color[3], insp->color[0], insp->color[1], insp->color[2]);
+    ft_raster_text(text_data, ZOOMER_INSPECTOR_TEXT_W, ZOOMER_INSPECTOR_TEXT_H, 4, 13, line);
+
+    if(insp->rect[2] > 0 && insp->rect[3] > 0) {
+        t_stats* stats = &insp->stats;
+
+        snprintf(line, sizeof(line), "REGION %d, %d %dX%d", insp->rect[0], insp->rect[1], insp->rect[2], insp->rect[3]);
+        ft_raster_text(text_data, ZOOMER_INSPECTOR_TEXT_W, ZOOMER_INSPECTOR_TEXT_H, 4, 22, line);
+
+        snprintf(line, sizeof(line), "MIN  %u %u %u %u", stats->min[0], stats->min[1], stats->min[2], stats->min[3]);
+        ft_raster_text(text_data, ZOOMER_INSPECTOR_TEXT_W, ZOOMER_INSPECTOR_TEXT_H, 4, 31, line);
+
+        snprintf(line, sizeof(line), "MAX  %u %u %u %u", stats->max[0], stats->max[1], stats->max[2], stats->max[3]);
+        ft_raster_text(text_data, ZOOMER_INSPECTOR_TEXT_W, ZOOMER_INSPECTOR_TEXT_H, 4, 40, line);
+
+        snprintf(line, sizeof(line), "MEAN %.1f %.1f %.1f %.1f", stats->mean[0], stats->mean[1], stats->mean[2], stats->mean[3]);
+        ft_raster_text(text_data, ZOOMER_INSPECTOR_TEXT_W, ZOOMER_INSPECTOR_TEXT_H, 4, 49, line);
+
+        snprintf(line, sizeof(line), "UNIQUE %u", stats->unique);
+        ft_raster_text(text_data, ZOOMER_INSPECTOR_TEXT_W, ZOOMER_INSPECTOR_TEXT_H, 4, 58, line);
+    }
+
+    ft_overlay_atlas(ZOOMER_ATLAS_READOUT_X, ZOOMER_ATLAS_READOUT_Y, ZOOMER_INSPECTOR_TEXT_W, ZOOMER_INSPECTOR_TEXT_H, text_data);
+
+    return 1;
+}
+
+int ft_raster_text(char* data, int w, int h, int x, int y, const char* text) {
+    // 5x7 bitmap font, one byte per row (the lowest 5 bits, the most significant one is the leftmost column)
+    // Only the characters used by the inspector are defined, the lowercase letters are drawn as the uppercase ones
+    static const char font_chars[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ#(),.:-/";
+    static const unsigned char font_glyphs[][7] = {
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+        { 0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e }, // '0'
+        { 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e }, // '1'
+        { 0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f }, // '2'
+        { 0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e }, // '3'
+        { 0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02 }, // '4'
+        { 0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e }, // '5'
+        { 0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e }, // '6'
+        { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // '7'
+        { 0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e }, // '8'
+        { 0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c }, // '9'
+        { 0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 }, // 'A'
+        { 0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e }, // 'B'
+        { 0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e }, // 'C'
+        { 0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c }, // 'D'
+        { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f }, // 'E'
+        { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10 }, // 'F'
+        { 0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f }, // 'G'
+        { 0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 }, // 'H'
+        { 0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e }, // 'I'
+        { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c }, // 'J'
+        { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, // 'K'
+        { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f }, // 'L'
+        { 0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11 }, // 'M'
+        { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, // 'N'
+        { 0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e }, // 'O'
+        { 0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10 }, // 'P'
+        { 0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d }, // 'Q'
+        { 0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11 }, // 'R'
+        { 0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e }, // 'S'
+        { 0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, // 'T'
+        { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e }, // 'U'
+        { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04 }, // 'V'
+        { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a }, // 'W'
+        { 0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11 }, // 'X'
+        { 0x11, 0x11, 0x11, 0x0a, 0x04, 0x04, 0x04 }, // 'Y'
+        { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f }, // 'Z'
+        { 0x0a, 0x0a, 0x1f, 0x0a, 0x1f, 0x0a, 0x0a }, // '#'
+        { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 }, // '('
+        { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 }, // ')'
+        { 0x00, 0x00, 0x00, 0x00, 0x0c, 0x04, 0x08 }, // ','
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c }, // '.'
+        { 0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x0c, 0x00 }, // ':'
+        { 0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00 }, // '-'
+        { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 }, // '/'
+    };
+
+    for(; *text && x + 5 <= w; text++, x += 6) {
+        char c = (*text >= 'a' && *text <= 'z') ? *text - 'a' + 'A' : *text;
+        const char* glyph = strchr(font_chars, c);
+        if(!glyph || !c)
+            continue;
+
+        for(int row = 0; row < 7 && y + row < h; row++) {
+            for(int col = 0; col < 5; col++) {
+                if(!(font_glyphs[glyph - font_chars][row] & (0x10 >> col)))
+                    continue;
+
+                char* pixel = data + ((y + row) * w + x + col) * 4;
+                pixel[0] = (char) 0xff;
+                pixel[1] = (char) 0xff;
+                pixel[2] = (char) 0xff;
+                pixel[3] = (char) 0xff;
+            }
+        }
+    }
+
+    return 1;
+}
+
+int ft_region_stats(t_inspector* insp, char* data, int w, int rect[4], t_stats* dest) {
+    // The region is split into horizontal bands, one per thread.
+    // Small regions aren't worth the cost of spawning the threads, so they use less of them
+    int jobs_count = (rect[2] * rect[3]) / ZOOMER_INSPECTOR_THREAD_PIXELS;
+    jobs_count = jobs_count < SDL_GetCPUCount() ? jobs_count : SDL_GetCPUCount();
+    jobs_count = jobs_count < rect[3] ? jobs_count : rect[3];
+    jobs_count = jobs_count < ZOOMER_INSPECTOR_THREADS ? jobs_count : ZOOMER_INSPECTOR_THREADS;
+    jobs_count = jobs_count > 1 ? jobs_count : 1;
+
+    static t_stats_job jobs[ZOOMER_INSPECTOR_THREADS];
+    SDL_Thread* threads[ZOOMER_INSPECTOR_THREADS] = { 0 };
+
+    for(int i = 0; i < jobs_count; i++) {
+        // Every thread marks the colors it has seen in its own bitset, so there's no need for any synchronization
+        if(!insp->colors[i]) {
+            insp->colors[i] = (unsigned long long*) malloc(ZOOMER_INSPECTOR_COLORS * sizeof(unsigned long long));
+
+            if(!insp->colors[i]) {
+                fprintf(stderr, "[ ERR ] Inspector: %s\n", strerror(errno));
+
+                return 0;
+            }
+        }
+
+        int y0 = rect[1] + (rect[3] * i) / jobs_count;
+        int y1 = rect[1] + (rect[3] * (i + 1)) / jobs_count;
+
+        jobs[i].data = (const unsigned char*) data;
+        jobs[i].stride = w;
+        jobs[i].rect[0] = rect[0];
+        jobs[i].rect[1] = y0;
+        jobs[i].rect[2] = rect[2];
+        jobs[i].rect[3] = y1 - y0;
+        jobs[i].colors = insp->colors[i];
+    }
+
+    // The 1st band is processed on the main thread (also as a fallback if the thread couldn't be created)
+    for(int i = 1; i < jobs_count; i++)
+        threads[i] = SDL_CreateThread(ft_region_stats_job, "zoomer-stats", &jobs[i]);
+
+    ft_region_stats_job(&jobs[0]);
+
+    for(int i = 1; i < jobs_count; i++) {
+        if(threads[i])
+            SDL_WaitThread(threads[i], NULL);
+        else
+            ft_region_stats_job(&jobs[i]);
+    }
+
+    // Merging the partial results
+    *dest = jobs[0].stats;
+    for(int i = 1; i < jobs_count; i++) {
+        t_stats* stats = &jobs[i].stats;
+
+        for(int c = 0; c < 4; c++) {
+            dest->min[c] = stats->min[c] < dest->min[c] ? stats->min[c] : dest->min[c];
+            dest->max[c] = stats->max[c] > dest->max[c] ? stats->max[c] : dest->max[c];
+            dest->sum[c] += stats->sum[c];
+
+            for(int v = 0; v < 256; v++)
+                dest->histogram[c][v] += stats->histogram[c][v];
+        }
+
+        dest->count += stats->count;
+    }
+
+    dest->unique = 0;
+    for(int i = 0; i < ZOOMER_INSPECTOR_COLORS; i++) {
+        unsigned long long word = insp->colors[0][i];
+
+        for(int j = 1; j < jobs_count; j++)
+            word |= insp->colors[j][i];
+
+        dest->unique += __builtin_popcountll(word);
+    }
+
+    for(int c = 0; c < 4; c++)
+        dest->mean[c] = dest->count ? (float) dest->sum[c] / dest->count : 0.0f;
+
+    return 1;
+}
+
+int ft_region_stats_job(void* arg) {
+    t_stats_job* job = (t_stats_job*) arg;
+    t_stats* stats = &job->stats;
+
+    memset(stats, 0, sizeof(t_stats));
+    memset(stats->min, 0xff, sizeof(stats->min));
+    memset(job->colors, 0, ZOOMER_INSPECTOR_COLORS * sizeof(unsigned long long));
+
+    int len = job->rect[2] * 4;
+
+    for(int y = job->rect[1]; y < job->rect[1] + job->rect[3]; y++) {
+        const unsigned char* row = job->data + ((size_t) y * job->stride + job->rect[0]) * 4;
+
+        // Min / max / sum are computed over 16 lanes (4 pixels) at the time.
+        // The lane 'k' always holds the channel 'k % 4'
+        unsigned char lane_min[16];
+        unsigned char lane_max[16] = { 0 };
+        unsigned int lane_sum[16] = { 0 };
+        memset(lane_min, 0xff, sizeof(lane_min));
+
+        int i = 0;
+
+#if defined(__SSE2__)
+
+        // SSE2: the sums are accumulated with '_mm_sad_epu8' (sum of absolute differences against zero),
+        // which adds up the bytes of each 8-byte half, so every channel is masked out and summed on its own
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i mask[4] = {
+            _mm_set1_epi32(0x000000ff),
+            _mm_set1_epi32(0x0000ff00),
+            _mm_set1_epi32(0x00ff0000),
+            _mm_set1_epi32((int) 0xff000000)
+        };
+
+        __m128i vec_min = _mm_set1_epi8((char) 0xff);
+        __m128i vec_max = zero;
+        __m128i vec_sum[4] = { zero, zero, zero, zero };
+
+        for(; i + 16 <= len; i += 16) {
+            __m128i pixels = _mm_loadu_si128((const __m128i*) (row + i));
+
+            vec_min = _mm_min_epu8(vec_min, pixels);
+            vec_max = _mm_max_epu8(vec_max, pixels);
+
+            for(int c = 0; c < 4; c++)
+                vec_sum[c] = _mm_add_epi64(vec_sum[c], _mm_sad_epu8(_mm_and_si128(pixels, mask[c]), zero));
+        }
+
+        _mm_storeu_si128((__m128i*) lane_min, vec_min);
+        _mm_storeu_si128((__m128i*) lane_max, vec_max);
+
+        for(int c = 0; c < 4; c++) {
+            unsigned long long sum[2];
+            _mm_storeu_si128((__m128i*) sum, vec_sum[c]);
+
+            stats->sum[c] += sum[0] + sum[1];
+        }
+
+#endif
+
+        // Portable path (also the tail of the SSE2 path)
+        for(; i + 16 <= len; i += 16) {
+            for(int k = 0; k < 16; k++) {
+                lane_min[k] = row[i + k] < lane_min[k] ? row[i + k] : lane_min[k];
+                lane_max[k] = row[i + k] > lane_max[k] ? row[i + k] : lane_max[k];
+                lane_sum[k] += row[i + k];
+            }
+        }
+
+        for(; i < len; i++) {
+            lane_min[i & 15] = row[i] < lane_min[i & 15] ? row[i] : lane_min[i & 15];
+            lane_max[i & 15] = row[i] > lane_max[i & 15] ? row[i] : lane_max[i & 15];
+            lane_sum[i & 15] += row[i];
+        }
+
+        for(int k = 0; k < 16; k++) {
+            stats->min[k & 3] = lane_min[k] < stats->min[k & 3] ? lane_min[k] : stats->min[k & 3];
+            stats->max[k & 3] = lane_max[k] > stats->max[k & 3] ? lane_max[k] : stats->max[k & 3];
+            stats->sum[k & 3] += lane_sum[k];
+        }
+
+        // Histogram and unique colors (scattered writes, so these stay scalar; this is the dominant cost of the job)
+        for(i = 0; i < len; i += 4) {
+            unsigned int rgb = (row[i + 0] << 16) | (row[i + 1] << 8) | row[i + 2];
+
+            stats->histogram[0][row[i + 0]]++;
+            stats->histogram[1][row[i + 1]]++;
+            stats->histogram[2][row[i + 2]]++;
+            stats->histogram[3][row[i + 3]]++;
+
+            job->colors[rgb >> 6] |= 1ULL << (rgb & 63);
+        }
+    }
+
+    stats->count = job->rect[2] * job->rect[3];
+
+    return 0;
+}
+
 // +--------------------------------------------------------------------------------+
 // |                                     LICENCE                                    |
 // +--------------------------------------------------------------------------------+